@@ -9,25 +9,59 @@
 // includes
 // --------
 
+#include <algorithm> // max
 #include <cassert>   // assert
 #include <cstddef>   // ptrdiff_t, size_t
+#include <cstring>   // memcpy
 #include <new>       // bad_alloc, new
 #include <stdexcept> // invalid_argument
 #include <iostream>
 
 using namespace std;
 
-// ---------
-// Allocator
-// ---------
+// ----------
+// debug mode
+// ----------
+
+// compile with -DALLOCATOR_DEBUG to guard, poison, and tag every block by default
+// in release builds the debug code is discarded by if constexpr and the block layout is unchanged
+
+#ifdef ALLOCATOR_DEBUG
+constexpr bool allocator_debug = true;
+#else
+constexpr bool allocator_debug = false;
+#endif
+
+#define ALLOCATOR_STRINGIFY2(x) #x
+#define ALLOCATOR_STRINGIFY(x)  ALLOCATOR_STRINGIFY2(x)
+
+// the call site, to be passed as the tag of allocate
+#define ALLOCATOR_TAG __FILE__ ":" ALLOCATOR_STRINGIFY(__LINE__)
+
+// ---------------
+// allocator_arena
+// ---------------
+
+/**
+ * the heap of my_allocator, everything but the leak report on destruction
+ * D selects the memory-debugging layout, a busy block of s is then
+ * [sentinel] [tag (8 bytes)] [s] [canary] [payload (s * 8 bytes)] [canary] [canary] ... [sentinel]
+ * and the interior of every free block is filled with poison
+ * blocks bumped out of a phase block (see begin_phase) carry no debug header
+ *
+ * the free blocks are also the nodes of a left-leaning red-black tree keyed by (size, offset)
+ * in a free block at head, head[1] holds the left link with the color in its low bit, and head[2] holds the right link
+ * a link is the offset of the child's head sentinel + 4, 0 for none, so links are never 0 and their low bit is free for the color
+ */
+template <typename T, std::size_t N, bool D>
+class allocator_arena {
+    static_assert(N % 8 == 0, "N must be a multiple of 8, so every free payload can hold a tree node");
 
-template <typename T, std::size_t N>
-class my_allocator {
     // -----------
     // operator ==
     // -----------
 
-    friend bool operator == (const my_allocator&, const my_allocator&) {
+    friend bool operator == (const allocator_arena&, const allocator_arena&) {
         return false;
     }                                                   // this is correct
 
@@ -35,7 +69,7 @@ class my_allocator {
     // operator !=
     // -----------
 
-    friend bool operator != (const my_allocator& lhs, const my_allocator& rhs) {
+    friend bool operator != (const allocator_arena& lhs, const allocator_arena& rhs) {
         return !(lhs == rhs);
     }
 
@@ -241,13 +275,27 @@ private:
     // ----
 
     char a[N];
+    int  _phase = -1;                               // offset of the phase block, -1 outside a phase
+    int  _top   = 0;                                // offset of the bump pointer in the phase block
+    int  _limit = 0;                                // offset of the end of the phase block's payload
+    int  _root  = 0;                                // link to the root of the free tree
+
+    // ---------
+    // constants
+    // ---------
+
+    static constexpr int guard  = D ? 3 : 0;           // extra 8-byte units per block in debug mode
+    static constexpr int canary = 0x5AFEC0DE;
+    static constexpr int poison = (int)0xDDDDDDDD;
+    static constexpr int fill   = D ? poison : 0;      // written into the interior of freed blocks
+    static constexpr int red    = 1;                   // color bit of the left link
 
     // -----
     // valid
     // -----
 
     /**
-     * O(1) in space
+     * O(log n) in space
      * O(n) in time
      * uses an iterator and check if it can reach the end, if all beginning sentinels match their end sentinels, and if no two free blocks are adjacent
      */
@@ -271,7 +319,37 @@ private:
                 return false;
             }
         }
-        return true;
+        int freeBlocks = 0;
+        for(b = begin(); b != e; ++b) {
+            freeBlocks += *b > 0 ? 1 : 0;
+        }
+        return count(_root, 0, 0, freeBlocks) == freeBlocks;
+    }
+
+    // -----
+    // count
+    // -----
+
+    /**
+     * O(log n) in space, the recursion follows one path of the tree
+     * O(n) in time
+     * the number of nodes in the subtree at e, if every one is a free block in (lo, hi) and there are at most limit of them
+     * -1 otherwise
+     */
+    int count (int e, int lo, int hi, int limit) const {
+        if(e == 0) {
+            return 0;
+        }
+        if(limit <= 0 || e < 4 || e > (int)N - 4 || e % 4 != 0 || node(e)[0] <= 0 ||
+                (lo != 0 && !less(lo, e)) || (hi != 0 && !less(e, hi))) {
+            return -1;
+        }
+        const int l = count(left(e), lo, e, limit - 1);
+        if(l == -1) {
+            return -1;
+        }
+        const int r = count(right(e), e, hi, limit - 1 - l);
+        return r == -1 ? -1 : 1 + l + r;
     }
 
 public:
@@ -284,21 +362,41 @@ public:
      * O(1) in time
      * throw a bad_alloc exception, if N is less than sizeof(T) + (2 * sizeof(int))
      */
-    my_allocator () {
+    allocator_arena () {
         (*this)[0] = N - 8; // replace!
         (*this)[N - 4] = N - 8;
         // <your code>
+        if constexpr (D) {
+            for(int i = 4; i != (int)N - 4; i += 4) {
+                (*this)[i] = poison;
+            }
+        }
+        insert_free(&(*this)[0]);
         assert(valid());
     }
 
-    my_allocator             (const my_allocator&) = default;
-    ~my_allocator            ()                    = default;
-    my_allocator& operator = (const my_allocator&) = default;
+    allocator_arena             (const allocator_arena&) = default;
+    ~allocator_arena            ()                       = default;
+    allocator_arena& operator = (const allocator_arena&) = default;
 
     bool isValid() {
         return valid();
     }
 
+    // ----
+    // owns
+    // ----
+
+    /**
+     * O(1) in space
+     * O(1) in time
+     * returns whether p points into this allocator's arena
+     */
+    bool owns (const_pointer p) const {
+        const char* q = reinterpret_cast<const char*>(p);
+        return q >= a && q < a + N;
+    }
+
     /*
     bool hasAvailableBlockAfterAllocation(int* p, size_type s) {
         iterator i = begin();
@@ -324,7 +422,7 @@ public:
     // --------
 
     /**
-     * O(1) in space
+     * O(log n) in space
      * O(n) in time
      * after allocation there must be enough space left for a valid block
      * the smallest allowable block is sizeof(T) + (2 * sizeof(int))
@@ -333,9 +431,23 @@ public:
      * finds the first available free block of a valid size and reapportions its sentinels into a new allocated block and the remaining free block
      */
     pointer allocate (size_type s) {
+        return allocate(s, nullptr);
+    }
+
+    /**
+     * in debug mode, tag (e.g. ALLOCATOR_TAG) is recorded in the block and shows up in the leak report
+     * in release mode, tag is ignored
+     * during a phase, bumps the pointer through the phase block and only falls back to first fit once it is used up
+     */
+    pointer allocate (size_type s, const char* tag) {
+        if(_phase != -1 && _top + (int)s * 8 <= _limit) {
+            pointer p = reinterpret_cast<T*>(a + _top);
+            _top += (int)s * 8;
+            return p;
+        }
         int* currentBlock = reinterpret_cast<int*>(a);
         bool foundAvailableBlock = false;
-        int newBlockSize = (int)s;
+        int newBlockSize = (int)s + guard;
         while(!foundAvailableBlock) {
             if(currentBlock == reinterpret_cast<int*>(a + N)) {
                 bad_alloc exception;
@@ -343,26 +455,8 @@ public:
                 return nullptr;
             }
             if(*currentBlock > 0) {
-                //cout << newBlockSize * 8 << " " << *currentBlock << endl;
-                //cout << hasAvailableBlockAfterAllocation(currentBlock, newBlockSize) << endl;
-                if(newBlockSize * 8 <= *currentBlock) { // && hasAvailableBlockAfterAllocation(currentBlock, newBlockSize)) {
-                    //cout << "Found the block! " << *currentBlock << endl;
+                if(newBlockSize * 8 <= *currentBlock) {
                     foundAvailableBlock = true;
-                    int oldBlockSize = *currentBlock;
-                    if(oldBlockSize - (newBlockSize * 8 + 8) < (int)sizeof(T)) {
-                        currentBlock[0] = -1 * oldBlockSize;
-                        currentBlock[oldBlockSize / 4 + 1] = -1 * oldBlockSize;
-                    }
-                    else {
-                        currentBlock[0] = -8 * newBlockSize;
-                        //cout << 0 << ": " << -8 * newBlockSize << endl;
-                        currentBlock[1 + 2 * newBlockSize] = -8 * newBlockSize;
-                        //cout << 1 + 2 * newBlockSize << ": " << -8 * newBlockSize << endl;
-                        currentBlock[2 + 2 * newBlockSize] = oldBlockSize - (newBlockSize * 8 + 8);
-                        //cout << 2 + 2 * newBlockSize << ": " << oldBlockSize - (newBlockSize * 8 + 8) << endl;
-                        currentBlock[oldBlockSize / 4 + 1] = oldBlockSize - (newBlockSize * 8 + 8);
-                    }
-                    //cout << oldBlockSize / 4 + 1 << ": " << oldBlockSize - (newBlockSize * 8 + 8) << endl;
                 }
                 else {
                     currentBlock += 1 + *currentBlock / 4 + 1;
@@ -372,8 +466,37 @@ public:
                 currentBlock += 1 + abs(*currentBlock) / 4 + 1;
             }
         }
-        assert(valid());
-        return reinterpret_cast<T*>(currentBlock + 1);
+        return split(currentBlock, s, tag);
+    }
+
+    // -----------------
+    // allocate_best_fit
+    // -----------------
+
+    /**
+     * O(log n) in space
+     * O(log n) in time
+     * like allocate, but chooses the smallest free block that fits, the one at the lowest address among equals
+     * throw a bad_alloc exception, if no free block fits
+     */
+    pointer allocate_best_fit (size_type s, const char* tag = nullptr) {
+        const int newBlockSize = (int)s + guard;
+        int best = 0;
+        int e = _root;
+        while(e != 0) {
+            if(newBlockSize * 8 <= node(e)[0]) {
+                best = e;
+                e = left(e);
+            }
+            else {
+                e = right(e);
+            }
+        }
+        if(best == 0) {
+            bad_alloc exception;
+            throw exception;
+        }
+        return split(node(best), s, tag);
     }
 
     // ---------
@@ -394,40 +517,570 @@ public:
     // ----------
 
     /**
-     * O(1) in space
-     * O(1) in time
+     * O(log n) in space
+     * O(log n) in time, plus O(s) to clear the freed block
      * after deallocation adjacent free blocks must be coalesced
      * throw an invalid_argument exception, if p is invalid
+     * the block may be larger than s, if allocate handed out a whole block rather than leaving a remainder too small to be valid
      * determines the positions of sentinels based on whether adjacent blocks are free and sets their size based off the coalesced (or not) blocks
+     * during a phase, blocks bumped out of the phase block are only given back by release
      */
     void deallocate (pointer p, size_type s) {
+        if(_phase != -1 && reinterpret_cast<char*>(p) > a + _phase && reinterpret_cast<char*>(p) < a + _limit) {
+            return;
+        }
         int* blockHead = reinterpret_cast<int*>(p) - 1;
-        if(*blockHead * -1 != (int)s * 8) {
+        if constexpr (D) {
+            blockHead -= 4;
+            if(owns(p) && blockHead[3] == (int)s) {
+                check(blockHead, cerr);
+            }
+        }
+        s += guard;
+        if(*blockHead * -1 < (int)s * 8 || *blockHead * -1 >= (int)(s * 8 + 8 + sizeof(T))) {
             //invalid_argument exception("Bad arguments passed to deallocate");
             throw invalid_argument("Bad arguments passed to deallocate");
             return;
         }
+        coalesce(blockHead, true);
+    }
+
+    // -----------
+    // begin_phase
+    // -----------
+
+    /**
+     * O(log n) in space
+     * O(log n) in time
+     * reserves the largest free block as a phase block, allocate then bumps a pointer through it and deallocate ignores its blocks
+     * throw a bad_alloc exception, if there is no free block
+     * throw a logic_error exception, if a phase has already begun
+     */
+    void begin_phase () {
+        if(_phase != -1) {
+            throw logic_error("Phase has already begun");
+        }
+        if(_root == 0) {
+            bad_alloc exception;
+            throw exception;
+        }
+        int* largest = node(largest_node());
+        erase_free(largest);
+        _phase = offset(largest);
+        _top   = _phase + 4;
+        _limit = _top + *largest;
+        largest[0] = -*largest;
+        largest[1 + -largest[0] / 4] = largest[0];
+        assert(valid());
+    }
+
+    // -------
+    // release
+    // -------
+
+    /**
+     * O(log n) in space
+     * O(log n) in time, O(n) in debug mode, where the phase block is poisoned
+     * ends the phase, every block bumped out of the phase block is freed at once and the phase block is free again
+     * the blocks bumped out of the phase block are never visited, only the phase block is coalesced and put back in the free tree
+     * does nothing outside a phase
+     */
+    void release () {
+        if(_phase == -1) {
+            return;
+        }
+        int* blockHead = reinterpret_cast<int*>(a + _phase);
+        _phase = -1;
+        coalesce(blockHead, D);
+    }
+
+    // --------
+    // in_phase
+    // --------
+
+    /**
+     * O(1) in space
+     * O(1) in time
+     */
+    bool in_phase () const {
+        return _phase != -1;
+    }
+
+    // -----------
+    // tree_height
+    // -----------
+
+    /**
+     * O(log n) in space
+     * O(n) in time
+     * the number of nodes on the longest path from the root of the free tree, which bounds the steps of allocate_best_fit
+     */
+    size_type tree_height () const {
+        return height(_root);
+    }
+
+    // --------
+    // max_size
+    // --------
+
+    /**
+     * O(1) in space
+     * O(1) in time
+     * the largest s that allocate can serve in an empty arena
+     */
+    size_type max_size () const {
+        return (N - 8) / 8 - guard;
+    }
+
+    // ----
+    // fits
+    // ----
+
+    /**
+     * O(1) in space
+     * O(log n) in time
+     * returns whether allocate(s) would succeed, either by bumping the phase pointer or in the largest coalesced free block
+     */
+    bool fits (size_type s) const {
+        if(_phase != -1 && _top + (int)s * 8 <= _limit) {
+            return true;
+        }
+        return _root != 0 && ((int)s + guard) * 8 <= node(largest_node())[0];
+    }
+
+private:
+    // --------
+    // coalesce
+    // --------
+
+    /**
+     * O(log n) in space
+     * O(log n) in time, O(n) if clear
+     * frees the busy block at blockHead and coalesces it with its free neighbours, in the sentinels and in the free tree
+     * if clear, also fills the interior of the new free block
+     */
+    void coalesce (int* blockHead, bool clear) {
         int* newBlockHead = blockHead;
         int* endBlockHead = blockHead + 1 + *blockHead / -4 + 1;
         int newSize = *newBlockHead * -1;
         if(reinterpret_cast<char*>(newBlockHead) != a && *(newBlockHead - 1) > 0) {
             newBlockHead -= 1 + *(newBlockHead - 1) / 4 + 1;
+            erase_free(newBlockHead);
             newSize += 8 + *newBlockHead;
         }
         if(reinterpret_cast<char*>(endBlockHead) != &a[N] && *endBlockHead > 0) {
+            erase_free(endBlockHead);
             newSize += 8 + *endBlockHead;
             endBlockHead += 1 + *endBlockHead / 4 + 1;
         }
+        int* head = newBlockHead;
         *newBlockHead = newSize;
         ++newBlockHead;
-        while(newBlockHead != endBlockHead) {
-            *newBlockHead = 0;
+        while(clear && newBlockHead != endBlockHead) {
+            *newBlockHead = fill;
             ++newBlockHead;
         }
         *(endBlockHead - 1) = newSize;
+        insert_free(head);
         assert(valid());
     }
 
+    // -----
+    // split
+    // -----
+
+    /**
+     * O(log n) in space
+     * O(log n) in time
+     * allocates s out of the free block at currentBlock, which must fit it
+     * reapportions its sentinels into a new allocated block and the remaining free block, and moves the remainder in the free tree
+     */
+    pointer split (int* currentBlock, size_type s, const char* tag) {
+        const int newBlockSize = (int)s + guard;
+        erase_free(currentBlock);
+        int oldBlockSize = *currentBlock;
+        if(oldBlockSize - (newBlockSize * 8 + 8) < (int)sizeof(T)) {
+            currentBlock[0] = -1 * oldBlockSize;
+            currentBlock[oldBlockSize / 4 + 1] = -1 * oldBlockSize;
+        }
+        else {
+            currentBlock[0] = -8 * newBlockSize;
+            currentBlock[1 + 2 * newBlockSize] = -8 * newBlockSize;
+            currentBlock[2 + 2 * newBlockSize] = oldBlockSize - (newBlockSize * 8 + 8);
+            currentBlock[oldBlockSize / 4 + 1] = oldBlockSize - (newBlockSize * 8 + 8);
+            insert_free(currentBlock + 2 + 2 * newBlockSize);
+        }
+        assert(valid());
+        if constexpr (D) {
+            std::memcpy(currentBlock + 1, &tag, sizeof(tag));
+            currentBlock[3] = (int)s;
+            currentBlock[4] = canary;
+            currentBlock[5 + 2 * s] = canary;
+            currentBlock[6 + 2 * s] = canary;
+            return reinterpret_cast<T*>(currentBlock + 5);
+        }
+        (void)tag;
+        return reinterpret_cast<T*>(currentBlock + 1);
+    }
+
+    // ---------
+    // free tree
+    // ---------
+
+    /**
+     * O(1) in space
+     * O(1) in time
+     * the head sentinel of the block linked to by e
+     */
+    int* node (int e) {
+        return reinterpret_cast<int*>(a + e - 4);
+    }
+
+    const int* node (int e) const {
+        return reinterpret_cast<const int*>(a + e - 4);
+    }
+
+    /**
+     * O(1) in space
+     * O(1) in time
+     * the link to the block at head
+     */
+    int link (const int* head) const {
+        return offset(head) + 4;
+    }
+
+    int left (int e) const {
+        return e == 0 ? 0 : node(e)[1] & ~red;
+    }
+
+    int right (int e) const {
+        return e == 0 ? 0 : node(e)[2];
+    }
+
+    bool is_red (int e) const {
+        return e != 0 && (node(e)[1] & red) != 0;
+    }
+
+    void set_left (int e, int l) {
+        node(e)[1] = l | (node(e)[1] & red);
+    }
+
+    void set_right (int e, int r) {
+        node(e)[2] = r;
+    }
+
+    void set_red (int e, bool r) {
+        if(e != 0) {
+            node(e)[1] = (node(e)[1] & ~red) | (r ? red : 0);
+        }
+    }
+
+    /**
+     * O(1) in space
+     * O(log n) in time
+     * the link to the largest free block, which must exist
+     */
+    int largest_node () const {
+        int e = _root;
+        while(right(e) != 0) {
+            e = right(e);
+        }
+        return e;
+    }
+
+    size_type height (int e) const {
+        return e == 0 ? 0 : 1 + std::max(height(left(e)), height(right(e)));
+    }
+
+    /**
+     * O(1) in space
+     * O(1) in time
+     * orders the free blocks by size, then by address
+     */
+    bool less (int x, int y) const {
+        return node(x)[0] < node(y)[0] || (node(x)[0] == node(y)[0] && x < y);
+    }
+
+    int rotate_left (int h) {
+        int x = right(h);
+        set_right(h, left(x));
+        set_left(x, h);
+        set_red(x, is_red(h));
+        set_red(h, true);
+        return x;
+    }
+
+    int rotate_right (int h) {
+        int x = left(h);
+        set_left(h, right(x));
+        set_right(x, h);
+        set_red(x, is_red(h));
+        set_red(h, true);
+        return x;
+    }
+
+    void flip (int h) {
+        set_red(h, !is_red(h));
+        set_red(left(h), !is_red(left(h)));
+        set_red(right(h), !is_red(right(h)));
+    }
+
+    int fix_up (int h) {
+        if(is_red(right(h)) && !is_red(left(h))) {
+            h = rotate_left(h);
+        }
+        if(is_red(left(h)) && is_red(left(left(h)))) {
+            h = rotate_right(h);
+        }
+        if(is_red(left(h)) && is_red(right(h))) {
+            flip(h);
+        }
+        return h;
+    }
+
+    int move_red_left (int h) {
+        flip(h);
+        if(is_red(left(right(h)))) {
+            set_right(h, rotate_right(right(h)));
+            h = rotate_left(h);
+            flip(h);
+        }
+        return h;
+    }
+
+    int move_red_right (int h) {
+        flip(h);
+        if(is_red(left(left(h)))) {
+            h = rotate_right(h);
+            flip(h);
+        }
+        return h;
+    }
+
+    /**
+     * O(log n) in space, the recursion follows one path of the tree
+     * O(log n) in time
+     * inserts the node n into the subtree at h and returns the new root of the subtree
+     */
+    int insert (int h, int n) {
+        if(h == 0) {
+            node(n)[1] = red;
+            node(n)[2] = 0;
+            return n;
+        }
+        if(less(n, h)) {
+            set_left(h, insert(left(h), n));
+        }
+        else {
+            set_right(h, insert(right(h), n));
+        }
+        return fix_up(h);
+    }
+
+    /**
+     * O(log n) in space, the recursion follows one path of the tree
+     * O(log n) in time
+     * removes the smallest node from the subtree at h and returns the new root of the subtree
+     */
+    int erase_min (int h) {
+        if(left(h) == 0) {
+            return 0;
+        }
+        if(!is_red(left(h)) && !is_red(left(left(h)))) {
+            h = move_red_left(h);
+        }
+        set_left(h, erase_min(left(h)));
+        return fix_up(h);
+    }
+
+    /**
+     * O(log n) in space, the recursion follows one path of the tree
+     * O(log n) in time
+     * removes the node n, which must be in the subtree at h, and returns the new root of the subtree
+     * the key is the block itself, so n is replaced by its successor node rather than by its successor's key
+     */
+    int erase (int h, int n) {
+        if(less(n, h)) {
+            if(!is_red(left(h)) && !is_red(left(left(h)))) {
+                h = move_red_left(h);
+            }
+            set_left(h, erase(left(h), n));
+        }
+        else {
+            if(is_red(left(h))) {
+                h = rotate_right(h);
+            }
+            if(n == h && right(h) == 0) {
+                return 0;
+            }
+            if(!is_red(right(h)) && !is_red(left(right(h)))) {
+                h = move_red_right(h);
+            }
+            if(n == h) {
+                int m = right(h);
+                while(left(m) != 0) {
+                    m = left(m);
+                }
+                const int r = erase_min(right(h));
+                set_left(m, left(h));
+                set_right(m, r);
+                set_red(m, is_red(h));
+                h = m;
+            }
+            else {
+                set_right(h, erase(right(h), n));
+            }
+        }
+        return fix_up(h);
+    }
+
+    /**
+     * O(log n) in space
+     * O(log n) in time
+     * adds the free block at head to the free tree
+     */
+    void insert_free (int* head) {
+        _root = insert(_root, link(head));
+        set_red(_root, false);
+    }
+
+    /**
+     * O(log n) in space
+     * O(log n) in time
+     * removes the free block at head from the free tree, before its size changes
+     */
+    void erase_free (int* head) {
+        if(!is_red(left(_root)) && !is_red(right(_root))) {
+            set_red(_root, true);
+        }
+        _root = erase(_root, link(head));
+        set_red(_root, false);
+    }
+
+public:
+    // -----
+    // check
+    // -----
+
+    /**
+     * O(1) in space
+     * O(n) in time
+     * in debug mode, writes every broken canary and every write into freed memory to out, with its offset in the arena
+     * returns the number of overwritten blocks, always 0 in release mode
+     */
+    size_type check (ostream& out) const {
+        size_type n = 0;
+        if constexpr (D) {
+            const_iterator b = begin();
+            const_iterator e = end();
+            while(b != e) {
+                n += check(&(*b), out) ? 1 : 0;
+                ++b;
+            }
+        }
+        return n;
+    }
+
+    // ------
+    // report
+    // ------
+
+    /**
+     * O(1) in space
+     * O(n) in time
+     * in debug mode, writes every overwrite and every block that is still allocated to out
+     * returns the number of overwritten or allocated blocks, always 0 in release mode
+     */
+    size_type report (ostream& out) const {
+        size_type n = check(out);
+        if constexpr (D) {
+            const_iterator b = begin();
+            const_iterator e = end();
+            while(b != e) {
+                if(*b < 0 && offset(&(*b)) != _phase) {
+                    out << "leak: block at offset " << offset(&(*b)) << ", " << (&(*b))[3] * 8 << " bytes, " << tag_of(&(*b)) << endl;
+                    ++n;
+                }
+                ++b;
+            }
+        }
+        return n;
+    }
+
+private:
+    // ------
+    // offset
+    // ------
+
+    /**
+     * O(1) in space
+     * O(1) in time
+     */
+    int offset (const int* p) const {
+        return (int)(reinterpret_cast<const char*>(p) - a);
+    }
+
+    // ------
+    // tag_of
+    // ------
+
+    /**
+     * O(1) in space
+     * O(1) in time
+     * the tag recorded by allocate in the debug header of a busy block
+     */
+    const char* tag_of (const int* head) const {
+        const char* t;
+        std::memcpy(&t, head + 1, sizeof(t));
+        return t == nullptr ? "untagged" : t;
+    }
+
+    // -----
+    // check
+    // -----
+
+    /**
+     * O(1) in space
+     * O(n) in time
+     * checks the canaries of a busy block or the poison of a free block past its tree node, and writes the first overwrite to out
+     * returns whether the block was overwritten
+     */
+    bool check (const int* head, ostream& out) const {
+        if(offset(head) == _phase) {
+            return false;
+        }
+        const int size = abs(*head);
+        if(*head > 0) {
+            for(const int* p = head + 3; p < head + 1 + size / 4; ++p) {
+                if(*p != poison) {
+                    out << "overwrite: offset " << offset(p) << " in free block at offset " << offset(head) << endl;
+                    return true;
+                }
+            }
+            return false;
+        }
+        const int s = head[3];
+        const int* p = nullptr;
+        if(s < 0 || (s + guard) * 8 > size) {
+            p = head + 3;
+        }
+        else if(head[4] != canary) {
+            p = head + 4;
+        }
+        else if(head[5 + 2 * s] != canary) {
+            p = head + 5 + 2 * s;
+        }
+        else if(head[6 + 2 * s] != canary) {
+            p = head + 6 + 2 * s;
+        }
+        if(p == nullptr) {
+            return false;
+        }
+        out << "overwrite: offset " << offset(p) << " in block at offset " << offset(head) << ", " << tag_of(head) << endl;
+        return true;
+    }
+
+public:
     // -------
     // destroy
     // -------
@@ -502,4 +1155,34 @@ public:
     }
 };
 
+// ---------
+// Allocator
+// ---------
+
+/**
+ * an allocator_arena, in release mode it adds nothing and keeps a trivial destructor
+ */
+template <typename T, std::size_t N, bool D = allocator_debug>
+class my_allocator : public allocator_arena<T, N, D> {
+};
+
+/**
+ * in debug mode, the destructor reports leaks and overwrites to cerr, while the arena is still alive
+ */
+template <typename T, std::size_t N>
+class my_allocator<T, N, true> : public allocator_arena<T, N, true> {
+public:
+    // -----------
+    // constructor
+    // -----------
+
+    my_allocator             ()                    = default;
+    my_allocator             (const my_allocator&) = default;
+    my_allocator& operator = (const my_allocator&) = default;
+
+    ~my_allocator () {
+        this->report(cerr);
+    }
+};
+
 #endif // Allocator_h
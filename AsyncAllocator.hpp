@@ -0,0 +1,279 @@
+// ----------------
+// AsyncAllocator.h
+// ----------------
+
+#ifndef AsyncAllocator_h
+#define AsyncAllocator_h
+
+// needs C++20 coroutines, with g++ 10 compile with -std=c++2a -fcoroutines
+
+// --------
+// includes
+// --------
+
+#include <coroutine> // coroutine_handle
+#include <cstddef>   // ptrdiff_t, size_t
+#include <new>       // bad_alloc
+
+#include "Allocator.hpp"
+
+// ---------------
+// async_allocator
+// ---------------
+
+/**
+ * a my_allocator whose allocate_async suspends the awaiting coroutine instead of throwing when no block fits
+ * waiters are resumed in FIFO order by deallocate, as soon as the largest coalesced free block fits the one at the head
+ * a coroutine that is waiting must not be destroyed before it is resumed
+ */
+template <typename T, std::size_t N>
+class async_allocator {
+    // -----------
+    // operator ==
+    // -----------
+
+    friend bool operator == (const async_allocator&, const async_allocator&) {
+        return false;
+    }
+
+    // -----------
+    // operator !=
+    // -----------
+
+    friend bool operator != (const async_allocator& lhs, const async_allocator& rhs) {
+        return !(lhs == rhs);
+    }
+
+public:
+    // --------
+    // typedefs
+    // --------
+
+    using      value_type = T;
+
+    using       size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+    using       pointer   =       value_type*;
+    using const_pointer   = const value_type*;
+
+    using       reference =       value_type&;
+    using const_reference = const value_type&;
+
+    using      arena_type = my_allocator<T, N>;
+
+    // -------
+    // awaiter
+    // -------
+
+    /**
+     * the result of allocate_async, co_await yields the allocated pointer
+     * it lives in the awaiting coroutine's frame and is its node in the FIFO of waiters
+     */
+    class awaiter {
+        friend async_allocator;
+
+    private:
+        // ----
+        // data
+        // ----
+
+        async_allocator&        _a;
+        size_type               _s;
+        pointer                 _p    = nullptr;
+        std::coroutine_handle<> _h;
+        awaiter*                _next = nullptr;
+
+    public:
+        // -----------
+        // constructor
+        // -----------
+
+        awaiter (async_allocator& a, size_type s) :
+            _a (a),
+            _s (s)
+        {}
+
+        /**
+         * O(log n) in space
+         * O(n) in time
+         * allocates without suspending, if nobody is waiting and s fits
+         * throw a bad_alloc exception, if s could not fit even in an empty arena
+         */
+        bool await_ready () {
+            if(_s > _a._x.max_size()) {
+                bad_alloc exception;
+                throw exception;
+            }
+            if(_a._head == nullptr && _a._x.fits(_s)) {
+                _p = _a._x.allocate(_s);
+                return true;
+            }
+            return false;
+        }
+
+        /**
+         * O(1) in space
+         * O(1) in time
+         * joins the end of the FIFO of waiters
+         */
+        void await_suspend (std::coroutine_handle<> h) {
+            _h = h;
+            if(_a._head == nullptr) {
+                _a._head = this;
+            }
+            else {
+                _a._tail->_next = this;
+            }
+            _a._tail = this;
+        }
+
+        pointer await_resume () const {
+            return _p;
+        }
+    };
+
+private:
+    // ----
+    // data
+    // ----
+
+    arena_type _x;
+    awaiter*   _head   = nullptr;               // the first waiter, the next one to be resumed
+    awaiter*   _tail   = nullptr;
+    bool       _waking = false;                 // whether deallocate is already resuming waiters further up the stack
+
+public:
+    // -----------
+    // constructor
+    // -----------
+
+    async_allocator             ()                       = default;
+    async_allocator             (const async_allocator&) = delete;
+    ~async_allocator            ()                       = default;
+    async_allocator& operator = (const async_allocator&) = delete;
+
+    bool isValid() {
+        return _x.isValid();
+    }
+
+    // -----
+    // arena
+    // -----
+
+    /**
+     * O(1) in space
+     * O(1) in time
+     */
+    const arena_type& arena () const {
+        return _x;
+    }
+
+    // -------
+    // waiting
+    // -------
+
+    /**
+     * O(1) in space
+     * O(n) in time, n being the number of waiters
+     */
+    size_type waiting () const {
+        size_type n = 0;
+        for(const awaiter* w = _head; w != nullptr; w = w->_next) {
+            ++n;
+        }
+        return n;
+    }
+
+    // --------
+    // allocate
+    // --------
+
+    /**
+     * O(log n) in space
+     * O(n) in time
+     * never jumps the FIFO, so a caller that keeps allocating cannot starve a waiting coroutine
+     * throw a bad_alloc exception, if a coroutine is waiting or no block fits
+     */
+    pointer allocate (size_type s) {
+        if(_head != nullptr) {
+            bad_alloc exception;
+            throw exception;
+        }
+        return _x.allocate(s);
+    }
+
+    // --------------
+    // allocate_async
+    // --------------
+
+    /**
+     * O(1) in space
+     * O(1) in time
+     * co_await allocate_async(s) yields a block of s, suspending until deallocate frees enough contiguous space
+     */
+    awaiter allocate_async (size_type s) {
+        return awaiter(*this, s);
+    }
+
+    // ---------
+    // construct
+    // ---------
+
+    /**
+     * O(1) in space
+     * O(1) in time
+     */
+    void construct (pointer p, const_reference v) {
+        _x.construct(p, v);
+    }
+
+    // ----------
+    // deallocate
+    // ----------
+
+    /**
+     * O(log n) in space
+     * O(log n) in time to free the block, plus O(n) per resumed waiter
+     * frees the block, then hands blocks to waiters in FIFO order while the head's request fits
+     * a waiter that is resumed may deallocate again, its waiters are then resumed by the outermost deallocate
+     * throw an invalid_argument exception, if p is invalid
+     */
+    void deallocate (pointer p, size_type s) {
+        _x.deallocate(p, s);
+        if(_waking) {
+            return;
+        }
+        _waking = true;
+        while(_head != nullptr && _x.fits(_head->_s)) {
+            awaiter* w = _head;
+            _head = w->_next;
+            if(_head == nullptr) {
+                _tail = nullptr;
+            }
+            w->_p = _x.allocate(w->_s);
+            try {
+                w->_h.resume();
+            }
+            catch(...) {
+                _waking = false;
+                throw;
+            }
+        }
+        _waking = false;
+    }
+
+    // -------
+    // destroy
+    // -------
+
+    /**
+     * O(1) in space
+     * O(1) in time
+     */
+    void destroy (pointer p) {
+        _x.destroy(p);
+    }
+};
+
+#endif // AsyncAllocator_h
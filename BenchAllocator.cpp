@@ -0,0 +1,417 @@
+// ------------------
+// BenchAllocator.c++
+// ------------------
+
+// --------
+// includes
+// --------
+
+#include <algorithm> // lower_bound
+#include <chrono>    // steady_clock
+#include <cstddef>   // size_t
+#include <cstdint>   // uint32_t
+#include <cstdio>    // printf
+#include <iostream>  // cin, cout
+#include <new>       // bad_alloc
+#include <random>    // mt19937
+#include <string>
+#include <vector>
+
+#include "Allocator.hpp"
+#include "SizeClassAllocator.hpp"
+#include "TypedArena.hpp"
+
+const std::size_t arena_bytes = 1000;   // the arena of RunAllocator, and of each size-class arena
+
+using size_class_type = size_class_allocator<double, arena_bytes, 8>;
+
+// first fit and best fit get as many bytes as all the size-class arenas together, so fragmentation is compared at equal footprint
+const std::size_t footprint = arena_bytes * (size_class_type::classes + 1);
+
+using first_fit_type  = my_allocator<double, footprint>;
+
+// ----------
+// heap_stats
+// ----------
+
+struct heap_stats {
+    std::size_t free_bytes   = 0;
+    std::size_t largest_free = 0;
+    std::size_t free_blocks  = 0;
+    std::size_t busy_blocks  = 0;
+};
+
+/**
+ * walks the blocks of an arena and sums up its free space
+ */
+template <typename A>
+heap_stats stats (const A& x) {
+    heap_stats r;
+    typename A::const_iterator b = x.begin();
+    typename A::const_iterator e = x.end();
+    while(b != e) {
+        if(*b > 0) {
+            r.free_bytes += *b;
+            r.largest_free = std::max<std::size_t>(r.largest_free, *b);
+            ++r.free_blocks;
+        }
+        else {
+            ++r.busy_blocks;
+        }
+        ++b;
+    }
+    return r;
+}
+
+/**
+ * the number of blocks a first-fit allocate of s visits in an arena
+ */
+template <typename A>
+std::size_t scan_length (const A& x, std::size_t s) {
+    std::size_t n = 0;
+    typename A::const_iterator b = x.begin();
+    typename A::const_iterator e = x.end();
+    while(b != e) {
+        ++n;
+        if(*b >= (int)s * 8) {
+            break;
+        }
+        ++b;
+    }
+    return n;
+}
+
+/**
+ * the fraction of free bytes that are not in the largest free block of their arena
+ */
+double fragmentation (const first_fit_type& x) {
+    heap_stats r = stats(x);
+    return r.free_bytes == 0 ? 0.0 : 1.0 - (double)r.largest_free / r.free_bytes;
+}
+
+double fragmentation (const size_class_type& x) {
+    std::size_t free_bytes = 0;
+    std::size_t stranded   = 0;
+    for(std::size_t i = 0; i <= size_class_type::classes; ++i) {
+        heap_stats r = stats(x.arena(i));
+        free_bytes += r.free_bytes;
+        stranded   += r.free_bytes - r.largest_free;
+    }
+    return free_bytes == 0 ? 0.0 : (double)stranded / free_bytes;
+}
+
+// ----------
+// trace_case
+// ----------
+
+struct trace_totals {
+    std::size_t allocations     = 0;
+    std::size_t operations      = 0;
+    std::size_t first_fit_scan  = 0;
+    std::size_t size_class_scan = 0;
+    std::size_t size_class_fail = 0;
+    std::size_t best_fit_fail   = 0;
+    double      first_fit_frag  = 0;
+    double      size_class_frag = 0;
+    double      best_fit_frag   = 0;
+};
+
+struct live_block {
+    double*     first_fit;
+    double*     size_class;
+    double*     best_fit;
+    std::size_t s;
+};
+
+/**
+ * replays one case of the RunAllocator input format against first fit, the size-class allocator, and best fit
+ * -n frees the nth busy block of the first-fit arena and the same logical block of the other allocators
+ */
+void trace_case (const std::vector<int>& ops, trace_totals& t) {
+    first_fit_type          x;
+    size_class_type         y;
+    first_fit_type          z;
+    std::vector<live_block> live;
+    for(int op : ops) {
+        if(op > 0) {
+            const std::size_t s = op;
+            const std::size_t i = size_class_type::arena_index(s);
+            t.first_fit_scan  += scan_length(x, s);
+            t.size_class_scan += i == size_class_type::classes ?
+                                 scan_length(y.arena(i), s) :
+                                 scan_length(y.arena(i), size_class_type::class_size(i));
+            ++t.allocations;
+            live_block b = {x.allocate(s), nullptr, nullptr, s};
+            try {
+                b.size_class = y.allocate(s);
+            }
+            catch(const bad_alloc&) {
+                ++t.size_class_fail;
+            }
+            try {
+                b.best_fit = z.allocate_best_fit(s);
+            }
+            catch(const bad_alloc&) {
+                ++t.best_fit_fail;
+            }
+            live.insert(std::lower_bound(live.begin(), live.end(), b,
+            [] (const live_block& l, const live_block& r) {
+                return l.first_fit < r.first_fit;
+            }), b);
+        }
+        else {
+            std::vector<live_block>::iterator b = live.begin() + (-op - 1);
+            x.deallocate(b->first_fit, b->s);
+            if(b->size_class != nullptr) {
+                y.deallocate(b->size_class, b->s);
+            }
+            if(b->best_fit != nullptr) {
+                z.deallocate(b->best_fit, b->s);
+            }
+            live.erase(b);
+        }
+        ++t.operations;
+        t.first_fit_frag  += fragmentation(x);
+        t.size_class_frag += fragmentation(y);
+        t.best_fit_frag   += fragmentation(z);
+    }
+}
+
+// -----------
+// bench_trace
+// -----------
+
+/**
+ * reads traces in the RunAllocator input format and reports the mean scan length and fragmentation of
+ * a single first-fit arena against the size-class allocator and best fit through the free tree
+ */
+void bench_trace (std::istream& in) {
+    using namespace std;
+    string s;
+    if(!getline(in, s) || s == "") {
+        return;
+    }
+    int numberOfCases = stoi(s);
+    getline(in, s);
+    trace_totals t;
+    for(int x = 0; x < numberOfCases; x++) {
+        vector<int> ops;
+        while(getline(in, s) && s != "") {
+            ops.push_back(stoi(s));
+        }
+        trace_case(ops, t);
+    }
+    if(t.allocations == 0) {
+        return;
+    }
+    printf("trace: %d cases, %zu operations, %zu allocations\n", numberOfCases, t.operations, t.allocations);
+    printf("%-12s %8s %12s %15s\n", "allocator", "bytes", "mean scan", "mean frag");
+    printf("%-12s %8zu %12.2f %15.3f\n", "first-fit",  footprint, (double)t.first_fit_scan  / t.allocations, t.first_fit_frag  / t.operations);
+    printf("%-12s %8zu %12.2f %15.3f\n", "size-class", footprint, (double)t.size_class_scan / t.allocations, t.size_class_frag / t.operations);
+    printf("%-12s %8zu %12s %15.3f\n",   "best-fit",   footprint, "O(log n)",                                   t.best_fit_frag   / t.operations);
+    if(t.size_class_fail != 0) {
+        printf("size-class: %zu allocations failed\n", t.size_class_fail);
+    }
+    if(t.best_fit_fail != 0) {
+        printf("best-fit: %zu allocations failed\n", t.best_fit_fail);
+    }
+}
+
+// --------------
+// generate_trace
+// --------------
+
+/**
+ * writes cases random cases in the RunAllocator input format to out, each valid for RunAllocator's my_allocator<double, 1000>
+ * three quarters of the requests are of 1 to 8 doubles and the rest of 9 to 24, and about 45% of the operations free a random busy block
+ */
+void generate_trace (std::ostream& out, std::size_t cases, std::uint32_t seed) {
+    std::mt19937 r(seed);
+    out << cases << "\n";
+    for(std::size_t c = 0; c != cases; ++c) {
+        my_allocator<double, arena_bytes> x;
+        std::size_t busy = 0;
+        const std::size_t n = 1 + r() % 1000;
+        out << "\n";
+        for(std::size_t i = 0; i != n; ++i) {
+            if(busy == 0 || r() % 100 >= 45) {
+                const std::size_t s = r() % 4 != 0 ? 1 + r() % 8 : 9 + r() % 16;
+                try {
+                    x.allocate(s);
+                    ++busy;
+                    out << s << "\n";
+                    continue;
+                }
+                catch(const bad_alloc&) {
+                    if(busy == 0) {
+                        continue;
+                    }
+                }
+            }
+            const std::size_t k = r() % busy;
+            my_allocator<double, arena_bytes>::iterator b = x.begin();
+            for(std::size_t j = 0; *b > 0 || j != k; ++b) {
+                j += *b < 0 ? 1 : 0;
+            }
+            x.deallocate(reinterpret_cast<double*>(&(*b) + 1), -*b / 8);
+            --busy;
+            out << "-" << k + 1 << "\n";
+        }
+    }
+}
+
+// -----
+// timer
+// -----
+
+/**
+ * the nanoseconds f takes per operation, over n operations
+ */
+template <typename F>
+double time_per_op (std::size_t n, F f) {
+    const std::chrono::steady_clock::time_point b = std::chrono::steady_clock::now();
+    f();
+    const std::chrono::steady_clock::time_point e = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(e - b).count() / n;
+}
+
+// -----------------
+// bench_typed_arena
+// -----------------
+
+struct small_object {
+    int x;
+};
+
+struct medium_object {
+    double x;
+    double y;
+    double z;
+};
+
+struct large_object {
+    char s[56];
+};
+
+const std::size_t objects = 100;      // live objects of each type per round
+const std::size_t rounds  = 2000;
+
+/**
+ * the units of 8 bytes my_allocator needs for one U
+ */
+template <typename U>
+constexpr std::size_t units () {
+    return (sizeof(U) + 7) / 8;
+}
+
+/**
+ * makes objects of three types interleaved, then destroys them, in one typed_arena and in three my_allocator instances
+ */
+void bench_typed_arena () {
+    using arena_type = typed_arena<1 << 14, small_object, medium_object, large_object>;
+    static arena_type                           x;
+    static my_allocator<small_object,  1 << 14> s;
+    static my_allocator<medium_object, 1 << 14> m;
+    static my_allocator<large_object,  1 << 14> l;
+    std::vector<small_object*>  ps(objects);
+    std::vector<medium_object*> pm(objects);
+    std::vector<large_object*>  pl(objects);
+    const std::size_t n = rounds * objects * 3;
+    const double t = time_per_op(n, [&] {
+        for(std::size_t r = 0; r != rounds; ++r) {
+            for(std::size_t i = 0; i != objects; ++i) {
+                ps[i] = x.make<small_object>();
+                pm[i] = x.make<medium_object>();
+                pl[i] = x.make<large_object>();
+            }
+            for(std::size_t i = 0; i != objects; ++i) {
+                x.destroy(ps[i]);
+                x.destroy(pm[i]);
+                x.destroy(pl[i]);
+            }
+        }
+    });
+    const double u = time_per_op(n, [&] {
+        for(std::size_t r = 0; r != rounds; ++r) {
+            for(std::size_t i = 0; i != objects; ++i) {
+                ps[i] = new (s.allocate(units<small_object>()))  small_object();
+                pm[i] = new (m.allocate(units<medium_object>())) medium_object();
+                pl[i] = new (l.allocate(units<large_object>()))  large_object();
+            }
+            for(std::size_t i = 0; i != objects; ++i) {
+                s.destroy(ps[i]);
+                s.deallocate(ps[i], units<small_object>());
+                m.destroy(pm[i]);
+                m.deallocate(pm[i], units<medium_object>());
+                l.destroy(pl[i]);
+                l.deallocate(pl[i], units<large_object>());
+            }
+        }
+    });
+    printf("\nmake/destroy of %zu live objects of 3 types, %zu rounds\n", objects, rounds);
+    printf("%-24s %12s %12s\n", "allocator", "ns / object", "bytes used");
+    printf("%-24s %12.1f %12zu\n", "typed_arena", t, x.used());
+    printf("%-24s %12.1f %12zu\n", "3 x my_allocator", u,
+           objects * (units<small_object>() + units<medium_object>() + units<large_object>() + 3) * 8);
+}
+
+// -----------
+// bench_phase
+// -----------
+
+const std::size_t burst  = 200;       // allocations per request
+const std::size_t bursts = 2000;
+
+/**
+ * allocates a burst of blocks of 1 to 4 doubles and then frees them all,
+ * once with split/coalesce on every call and once inside a phase ended by release
+ */
+void bench_phase () {
+    static my_allocator<double, 1 << 14> x;
+    std::vector<double*> p(burst);
+    const std::size_t n = bursts * burst;
+    const double t = time_per_op(n, [&] {
+        for(std::size_t r = 0; r != bursts; ++r) {
+            for(std::size_t i = 0; i != burst; ++i) {
+                p[i] = x.allocate(1 + i % 4);
+            }
+            for(std::size_t i = 0; i != burst; ++i) {
+                x.deallocate(p[i], 1 + i % 4);
+            }
+        }
+    });
+    const double u = time_per_op(n, [&] {
+        for(std::size_t r = 0; r != bursts; ++r) {
+            x.begin_phase();
+            for(std::size_t i = 0; i != burst; ++i) {
+                p[i] = x.allocate(1 + i % 4);
+            }
+            for(std::size_t i = 0; i != burst; ++i) {
+                x.deallocate(p[i], 1 + i % 4);
+            }
+            x.release();
+        }
+    });
+    printf("\nburst of %zu allocations then %zu deallocations, %zu bursts\n", burst, burst, bursts);
+    printf("%-24s %12s\n", "allocator", "ns / block");
+    printf("%-24s %12.1f\n", "split/coalesce", t);
+    printf("%-24s %12.1f\n", "phase + release", u);
+}
+
+// ----
+// main
+// ----
+
+// BenchAllocator [-g cases [seed]]
+// with -g, writes a random trace for BenchAllocator or RunAllocator to standard output instead
+
+int main (int argc, char** argv) {
+    if(argc > 2 && std::string(argv[1]) == "-g") {
+        generate_trace(std::cout, std::stoul(argv[2]), argc > 3 ? std::stoul(argv[3]) : 1);
+        return 0;
+    }
+    bench_trace(std::cin);
+    bench_typed_arena();
+    bench_phase();
+    return 0;
+}
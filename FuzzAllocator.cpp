@@ -0,0 +1,371 @@
+// -----------------
+// FuzzAllocator.c++
+// -----------------
+
+// differential fuzzing of my_allocator against a reference model of the heap
+// built with -DALLOCATOR_LIBFUZZER and -fsanitize=fuzzer, libFuzzer drives fuzz_one
+// otherwise main runs random inputs through it: FuzzAllocator [operations [seed]]
+
+// --------
+// includes
+// --------
+
+#include <algorithm> // max
+#include <chrono>    // steady_clock
+#include <cstddef>   // size_t
+#include <cstdint>   // uint8_t, uint64_t
+#include <cstdio>    // fprintf
+#include <cstdlib>   // abort, strtoull
+#include <new>       // bad_alloc
+#include <stdexcept> // logic_error
+#include <vector>
+
+#include "Allocator.hpp"
+
+const std::size_t arena  = 4096;
+const std::size_t every  = 64;         // operations between full comparisons with the model
+
+using allocator_type = my_allocator<double, arena>;
+
+const std::size_t scan_runs   = 128;  // first-fit allocations a run needs before its scan budget is checked
+const double      scan_budget = 0.75; // the fraction of the heap's blocks first fit may visit on average over a run
+
+std::size_t worst_scan   = 0;          // the most blocks a first-fit allocate has visited before the block it chose
+std::size_t worst_blocks = 0;          // the blocks in the heap at that allocate
+double      worst_mean   = 0;          // the largest fraction of the heap's blocks visited on average over a checked run
+
+// ------
+// expect
+// ------
+
+#define expect(c) ((c) ? (void)0 : fail(#c, __LINE__))
+
+[[noreturn]] void fail (const char* c, int line) {
+    fprintf(stderr, "FuzzAllocator.cpp:%d: invariant failed: %s\n", line, c);
+    abort();
+}
+
+// -----
+// model
+// -----
+
+/**
+ * the heap as a list of signed block sizes in address order, negative for busy blocks, like RunAllocator.ctd
+ * during a phase, the phase block is busy and blocks are bumped out of [top, limit)
+ */
+struct model {
+    std::vector<int> heap  = {(int)arena - 8};
+    int              phase = -1;
+    int              top   = 0;
+    int              limit = 0;
+
+    /**
+     * the offset of the head sentinel of block i
+     */
+    int offset (std::size_t i) const {
+        int r = 0;
+        for(std::size_t j = 0; j != i; ++j) {
+            r += abs(heap[j]) + 8;
+        }
+        return r;
+    }
+
+    /**
+     * the block first fit or best fit chooses for s, heap.size() if there is none
+     */
+    std::size_t find (std::size_t s, bool best) const {
+        std::size_t r = heap.size();
+        for(std::size_t i = 0; i != heap.size(); ++i) {
+            if(heap[i] >= (int)s * 8) {
+                if(!best) {
+                    return i;
+                }
+                if(r == heap.size() || heap[i] < heap[r]) {
+                    r = i;
+                }
+            }
+        }
+        return r;
+    }
+
+    /**
+     * the free block begin_phase reserves, the largest and the last among equals, heap.size() if there is none
+     */
+    std::size_t largest () const {
+        std::size_t r = heap.size();
+        for(std::size_t i = 0; i != heap.size(); ++i) {
+            if(heap[i] > 0 && (r == heap.size() || heap[i] >= heap[r])) {
+                r = i;
+            }
+        }
+        return r;
+    }
+
+    void begin_phase (std::size_t i) {
+        phase   = offset(i);
+        top     = phase + 4;
+        limit   = top + heap[i];
+        heap[i] = -heap[i];
+    }
+
+    void allocate (std::size_t i, std::size_t s) {
+        const int h = heap[i];
+        if(h - ((int)s * 8 + 8) < (int)sizeof(double)) {
+            heap[i] = -h;
+        }
+        else {
+            heap[i] = -(int)s * 8;
+            heap.insert(heap.begin() + i + 1, h - (int)s * 8 - 8);
+        }
+    }
+
+    void deallocate (int o) {
+        std::size_t i = 0;
+        for(int r = 0; r != o; r += abs(heap[i]) + 8, ++i) {
+        }
+        heap[i] = -heap[i];
+        if(i + 1 != heap.size() && heap[i + 1] > 0) {
+            heap[i] += heap[i + 1] + 8;
+            heap.erase(heap.begin() + i + 1);
+        }
+        if(i != 0 && heap[i - 1] > 0) {
+            heap[i - 1] += heap[i] + 8;
+            heap.erase(heap.begin() + i);
+        }
+    }
+};
+
+// ----------
+// live_block
+// ----------
+
+struct live_block {
+    double*     p;
+    std::size_t s;
+    double      v;
+    bool        bumped;                // bumped out of the phase block, freed only by release
+};
+
+// -------
+// compare
+// -------
+
+/**
+ * the sampled invariants: valid(), the heap matches the model block for block, no two free blocks are adjacent,
+ * the free tree is balanced, and the live blocks are intact
+ */
+void compare (allocator_type& x, const model& m, const std::vector<live_block>& live) {
+    expect(x.isValid());
+    std::size_t i = 0;
+    std::size_t frees = 0;
+    bool previousFree = false;
+    for(allocator_type::iterator b = x.begin(); b != x.end(); ++b, ++i) {
+        expect(i < m.heap.size() && *b == m.heap[i]);
+        expect(!(previousFree && *b > 0));
+        previousFree = *b > 0;
+        frees += *b > 0 ? 1 : 0;
+    }
+    expect(i == m.heap.size());
+    std::size_t bound = 0;
+    while(((std::size_t)1 << bound) <= frees) {
+        ++bound;
+    }
+    expect(x.tree_height() <= 2 * bound);
+    for(const live_block& l : live) {
+        expect(*l.p == l.v);
+    }
+}
+
+// ----
+// scan
+// ----
+
+struct scan_totals {
+    std::size_t allocations = 0;
+    std::size_t visited     = 0;
+    std::size_t blocks      = 0;
+};
+
+/**
+ * counts the blocks a first-fit allocate visited before choosing the block at p, out of the blocks of the model's heap
+ */
+void scan (allocator_type& x, const double* p, const model& m, scan_totals& t) {
+    const int*  head = reinterpret_cast<const int*>(p) - 1;
+    std::size_t n    = 0;
+    for(allocator_type::iterator b = x.begin(); &(*b) != head; ++b) {
+        ++n;
+    }
+    ++t.allocations;
+    t.visited += n;
+    t.blocks  += m.heap.size();
+    if(n > worst_scan) {
+        worst_scan   = n;
+        worst_blocks = m.heap.size();
+    }
+}
+
+/**
+ * the scan budget: over a run with enough first-fit allocations, first fit must visit
+ * at most scan_budget of the heap's blocks on average before finding a fit
+ */
+void check_scan (const scan_totals& t) {
+    if(t.allocations < scan_runs) {
+        return;
+    }
+    const double mean = (double)t.visited / t.blocks;
+    expect(mean <= scan_budget);
+    worst_mean = std::max(worst_mean, mean);
+}
+
+// --------
+// fuzz_one
+// --------
+
+/**
+ * decodes data as two bytes per operation:
+ *     op % 32 == 30: begin_phase
+ *     op % 32 == 31: release, which ends the phase and drops the blocks bumped out of it
+ *     op % 4  == 0:  allocate 1 + arg % 16 first fit, or bump it out of the phase block
+ *     op % 4  == 1:  allocate 1 + arg % 16 best fit
+ *     otherwise:     deallocate live block arg % live (after checking its contents)
+ * every allocation also constructs a value in its block
+ * returns the number of operations run
+ */
+std::size_t fuzz_one (const std::uint8_t* data, std::size_t size) {
+    allocator_type          x;
+    model                   m;
+    std::vector<live_block> live;
+    scan_totals             t;
+    const char* base = reinterpret_cast<const char*>(&(*x.begin()));
+    std::size_t n = 0;
+    for(; n * 2 + 1 < size; ++n) {
+        const std::uint8_t op  = data[n * 2];
+        const std::uint8_t arg = data[n * 2 + 1];
+        if(op % 32 == 30) {
+            const std::size_t i = m.largest();
+            bool began = false;
+            bool again = false;
+            try {
+                x.begin_phase();
+                began = true;
+            }
+            catch(const logic_error&) {
+                again = true;
+            }
+            catch(const bad_alloc&) {
+            }
+            expect(again == (m.phase != -1));
+            expect(began == (!again && i != m.heap.size()));
+            if(began) {
+                m.begin_phase(i);
+            }
+        }
+        else if(op % 32 == 31) {
+            for(std::size_t k = 0; k != live.size();) {
+                if(live[k].bumped) {
+                    expect(*live[k].p == live[k].v);
+                    live[k] = live.back();
+                    live.pop_back();
+                }
+                else {
+                    ++k;
+                }
+            }
+            x.release();
+            expect(!x.in_phase());
+            if(m.phase != -1) {
+                m.deallocate(m.phase);
+                m.phase = -1;
+            }
+        }
+        else if(op % 4 >= 2 && !live.empty()) {
+            const std::size_t k = arg % live.size();
+            const live_block  l = live[k];
+            expect(*l.p == l.v);
+            x.destroy(l.p);
+            x.deallocate(l.p, l.s);
+            if(!l.bumped) {
+                m.deallocate((int)(reinterpret_cast<const char*>(l.p) - base) - 4);
+            }
+            live[k] = live.back();
+            live.pop_back();
+        }
+        else if(op % 4 < 2) {
+            const std::size_t s    = 1 + arg % 16;
+            const bool        best = op % 4 == 1;
+            const bool        bump = !best && m.phase != -1 && m.top + (int)s * 8 <= m.limit;
+            const std::size_t i    = bump ? m.heap.size() : m.find(s, best);
+            double* p = nullptr;
+            try {
+                p = best ? x.allocate_best_fit(s) : x.allocate(s);
+            }
+            catch(const bad_alloc&) {
+            }
+            expect((p == nullptr) == (!bump && i == m.heap.size()));
+            if(p != nullptr) {
+                if(bump) {
+                    expect(reinterpret_cast<const char*>(p) - base == m.top);
+                    m.top += (int)s * 8;
+                }
+                else {
+                    expect(reinterpret_cast<const char*>(p) - base - 4 == m.offset(i));
+                    if(!best) {
+                        scan(x, p, m, t);
+                    }
+                    m.allocate(i, s);
+                }
+                const double v = (double)n;
+                x.construct(p, v);
+                live.push_back({p, s, v, bump});
+            }
+        }
+        if(n % every == 0) {
+            compare(x, m, live);
+        }
+    }
+    compare(x, m, live);
+    check_scan(t);
+    return n;
+}
+
+#ifdef ALLOCATOR_LIBFUZZER
+
+// ----------------------
+// LLVMFuzzerTestOneInput
+// ----------------------
+
+extern "C" int LLVMFuzzerTestOneInput (const std::uint8_t* data, std::size_t size) {
+    fuzz_one(data, size);
+    return 0;
+}
+
+#else
+
+// ----
+// main
+// ----
+
+int main (int argc, char** argv) {
+    const std::uint64_t operations = argc > 1 ? strtoull(argv[1], nullptr, 10) : 10000000;
+    std::uint64_t       seed       = argc > 2 ? strtoull(argv[2], nullptr, 10) : 1;
+    std::vector<std::uint8_t> data(4096);
+    std::uint64_t n = 0;
+    const std::chrono::steady_clock::time_point b = std::chrono::steady_clock::now();
+    while(n < operations) {
+        for(std::uint8_t& c : data) {
+            seed ^= seed << 13;
+            seed ^= seed >> 7;
+            seed ^= seed << 17;
+            c = (std::uint8_t)(seed >> 32);
+        }
+        n += fuzz_one(data.data(), data.size());
+    }
+    const std::chrono::steady_clock::time_point e = std::chrono::steady_clock::now();
+    const double seconds = std::chrono::duration<double>(e - b).count();
+    printf("%llu operations in %.2f s, %.2f million operations per second\n", (unsigned long long)n, seconds, n / seconds / 1e6);
+    printf("worst first-fit scan: %zu of %zu blocks visited\n", worst_scan, worst_blocks);
+    printf("worst mean first-fit scan over a run: %.2f of the blocks, budget %.2f\n", worst_mean, scan_budget);
+    return 0;
+}
+
+#endif
@@ -6,10 +6,13 @@
 // includes
 // --------
 
+#include <algorithm> // max
+#include <fstream>  // ofstream
 #include <iostream> // cin, cout
 #include <string>
 #include <vector>
 #include "Allocator.hpp"
+#include "Snapshot.hpp"
 
 void printAllocator(my_allocator<double, 1000>& a) {
     my_allocator<double, 1000>::iterator b = a.begin();
@@ -28,13 +31,24 @@ void printAllocator(my_allocator<double, 1000>& a) {
 // main
 // ----
 
-int main () {
+int main (int argc, char** argv) {
     using namespace std;
     /*
     your code for the read eval print loop (REPL) goes here
     in this project, the unit tests will only be testing Allocator.hpp, not the REPL
     the acceptance tests will be testing the REPL
     */
+    // RunAllocator [snapshot-file [period]]
+    // writes a snapshot of the heap (see Snapshot.hpp) to snapshot-file every period operations, snapshot-file is truncated first
+    ofstream snapshots;
+    size_t period = 1;
+    size_t tick = 0;
+    if(argc > 1) {
+        snapshots.open(argv[1], ios::binary);
+    }
+    if(argc > 2) {
+        period = max(stoi(argv[2]), 1);
+    }
     string s;
     getline(cin, s);
     int numberOfCases = stoi(s);
@@ -68,6 +82,10 @@ int main () {
                 a.deallocate(reinterpret_cast<double*>(&(*i) + 1), -1 * *i / 8);
             }
             //printAllocator(a);
+            ++tick;
+            if(snapshots.is_open() && tick % period == 0) {
+                write_snapshot(snapshots, a, tick);
+            }
         }
         printAllocator(a);
     }
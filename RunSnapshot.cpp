@@ -0,0 +1,125 @@
+// ---------------
+// RunSnapshot.c++
+// ---------------
+
+// reads a sequence of snapshots (see Snapshot.hpp) from standard input
+// prints one line of fragmentation metrics per snapshot
+// if given a file name, also writes a heat map of the arena over time to it as a binary PGM image,
+// one row per snapshot, one column per slice of the arena, darker meaning more of the slice is busy
+
+// --------
+// includes
+// --------
+
+#include <algorithm> // max, min
+#include <cstddef>   // size_t
+#include <cstdio>    // printf
+#include <cstdlib>   // abs
+#include <fstream>   // ofstream
+#include <iostream>  // cin, cerr
+#include <vector>
+
+#include "Snapshot.hpp"
+
+// -------
+// columns
+// -------
+
+const std::size_t columns = 256;
+
+// -------
+// metrics
+// -------
+
+/**
+ * prints the tick, free bytes, free blocks, largest free block, and fragmentation of a snapshot
+ * fragmentation is the fraction of free bytes that are not in the largest free block
+ */
+void metrics (const snapshot& x) {
+    std::size_t free_bytes   = 0;
+    std::size_t free_blocks  = 0;
+    std::size_t busy_blocks  = 0;
+    std::size_t largest_free = 0;
+    for(const std::pair<std::size_t, int>& r : x.runs) {
+        if(r.second > 0) {
+            free_bytes  += r.first * r.second;
+            free_blocks += r.first;
+            largest_free = std::max<std::size_t>(largest_free, r.second);
+        }
+        else {
+            busy_blocks += r.first;
+        }
+    }
+    const double fragmentation = free_bytes == 0 ? 0.0 : 1.0 - (double)largest_free / free_bytes;
+    printf("%10zu %10zu %10zu %10zu %10zu %10.3f\n", x.tick, free_bytes, free_blocks, busy_blocks, largest_free, fragmentation);
+}
+
+// ---
+// row
+// ---
+
+/**
+ * the busy fraction of each of width slices of the arena, as gray levels from 255 (free) to 0 (busy)
+ */
+std::vector<unsigned char> row (const snapshot& x, std::size_t width) {
+    std::vector<double> busy(width, 0.0);
+    const double slice = (double)x.arena / width;
+    std::size_t offset = 0;
+    for(const std::pair<std::size_t, int>& r : x.runs) {
+        const std::size_t span = std::abs(r.second) + 8;
+        for(std::size_t n = 0; n != r.first; ++n, offset += span) {
+            if(r.second > 0) {
+                continue;
+            }
+            double b = offset;
+            const double e = offset + span;
+            while(b < e) {
+                const std::size_t i = std::min<std::size_t>(b / slice, width - 1);
+                double end = std::min(e, (i + 1) * slice);
+                if(end <= b) {
+                    end = std::min(e, b + slice);
+                }
+                busy[i] += end - b;
+                b = end;
+            }
+        }
+    }
+    std::vector<unsigned char> r(width);
+    for(std::size_t i = 0; i != width; ++i) {
+        r[i] = (unsigned char)(255 - std::min(busy[i] / slice, 1.0) * 255);
+    }
+    return r;
+}
+
+// ----
+// main
+// ----
+
+int main (int argc, char** argv) {
+    using namespace std;
+    vector<vector<unsigned char>> image;
+    size_t width = 0;
+    snapshot x;
+    printf("%10s %10s %10s %10s %10s %10s\n", "tick", "free", "free blks", "busy blks", "largest", "frag");
+    while(read_snapshot(cin, x)) {
+        metrics(x);
+        if(argc > 1 && x.arena != 0) {
+            if(width == 0) {
+                width = min(columns, x.arena / 8);
+            }
+            image.push_back(row(x, width));
+        }
+    }
+    if(argc > 1 && !image.empty()) {
+        ofstream out(argv[1], ios::binary);
+        if(!out) {
+            cerr << "cannot write " << argv[1] << endl;
+            return 1;
+        }
+        out << "P5\n" << width << " " << image.size() << "\n255\n";
+        for(const vector<unsigned char>& r : image) {
+            out.write(reinterpret_cast<const char*>(r.data()), r.size());
+        }
+    }
+    return 0;
+}
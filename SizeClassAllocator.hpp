@@ -0,0 +1,230 @@
+// --------------------
+// SizeClassAllocator.h
+// --------------------
+
+#ifndef SizeClassAllocator_h
+#define SizeClassAllocator_h
+
+// --------
+// includes
+// --------
+
+#include <array>     // array
+#include <cstddef>   // ptrdiff_t, size_t
+#include <new>       // bad_alloc, new
+#include <stdexcept> // invalid_argument
+
+#include "Allocator.hpp"
+
+// ---------------
+// size_class_log2
+// ---------------
+
+/**
+ * O(1) in space
+ * O(log n) in time
+ * returns the floor of log2(n), with size_class_log2(0) == 0
+ */
+constexpr std::size_t size_class_log2 (std::size_t n) {
+    return n <= 1 ? 0 : 1 + size_class_log2(n / 2);
+}
+
+// --------------------
+// size_class_allocator
+// --------------------
+
+/**
+ * routes every request to a my_allocator arena dedicated to its size class
+ * the size classes are the powers of two 1, 2, 4, ..., M (in units of T)
+ * requests larger than M, or that no longer fit in their class, go to a large-object arena
+ */
+template <typename T, std::size_t N, std::size_t M = 8>
+class size_class_allocator {
+    static_assert(M > 0 && (M & (M - 1)) == 0, "the threshold M must be a power of two");
+
+    // -----------
+    // operator ==
+    // -----------
+
+    friend bool operator == (const size_class_allocator&, const size_class_allocator&) {
+        return false;
+    }
+
+    // -----------
+    // operator !=
+    // -----------
+
+    friend bool operator != (const size_class_allocator& lhs, const size_class_allocator& rhs) {
+        return !(lhs == rhs);
+    }
+
+public:
+    // --------
+    // typedefs
+    // --------
+
+    using      value_type = T;
+
+    using       size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+    using       pointer   =       value_type*;
+    using const_pointer   = const value_type*;
+
+    using       reference =       value_type&;
+    using const_reference = const value_type&;
+
+    using      arena_type = my_allocator<T, N>;
+
+    // ---------
+    // constants
+    // ---------
+
+    /**
+     * number of size-class arenas, the large-object arena has index classes
+     */
+    static constexpr size_type classes = size_class_log2(M) + 1;
+
+private:
+    // ----
+    // data
+    // ----
+
+    std::array<arena_type, classes + 1> _arenas;
+
+public:
+    // -----------
+    // constructor
+    // -----------
+
+    size_class_allocator             ()                            = default;
+    size_class_allocator             (const size_class_allocator&) = default;
+    ~size_class_allocator            ()                            = default;
+    size_class_allocator& operator = (const size_class_allocator&) = default;
+
+    bool isValid() {
+        for(arena_type& x : _arenas) {
+            if(!x.isValid()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // -----------
+    // arena_index
+    // -----------
+
+    /**
+     * O(1) in space
+     * O(log M) in time
+     * returns the index of the arena that serves a request of s, classes if s is larger than M
+     */
+    static size_type arena_index (size_type s) {
+        if(s > M) {
+            return classes;
+        }
+        size_type i = 0;
+        while(class_size(i) < s) {
+            ++i;
+        }
+        return i;
+    }
+
+    // ----------
+    // class_size
+    // ----------
+
+    /**
+     * O(1) in space
+     * O(1) in time
+     * returns the number of T in a block of size class i
+     */
+    static size_type class_size (size_type i) {
+        return size_type(1) << i;
+    }
+
+    // -----
+    // arena
+    // -----
+
+    /**
+     * O(1) in space
+     * O(1) in time
+     */
+    const arena_type& arena (size_type i) const {
+        return _arenas[i];
+    }
+
+    // --------
+    // allocate
+    // --------
+
+    /**
+     * O(log n) in space
+     * O(n) in time, n being the number of blocks in the chosen arena
+     * small requests are rounded up to their size class, so every block in a class arena has the same size
+     * falls back to the large-object arena when the class arena is full
+     * throw a bad_alloc exception, if no arena can serve s
+     */
+    pointer allocate (size_type s) {
+        const size_type i = arena_index(s);
+        if(i != classes) {
+            try {
+                return _arenas[i].allocate(class_size(i));
+            }
+            catch(const bad_alloc&) {
+            }
+        }
+        return _arenas[classes].allocate(s);
+    }
+
+    // ---------
+    // construct
+    // ---------
+
+    /**
+     * O(1) in space
+     * O(1) in time
+     */
+    void construct (pointer p, const_reference v) {
+        new (p) T(v);
+    }
+
+    // ----------
+    // deallocate
+    // ----------
+
+    /**
+     * O(log n) in space
+     * O(log n) in time, plus O(s) to clear the freed block
+     * finds the arena that owns p and gives the block back to it
+     * throw an invalid_argument exception, if p is not owned by any arena
+     */
+    void deallocate (pointer p, size_type s) {
+        const size_type i = arena_index(s);
+        if(i != classes && _arenas[i].owns(p)) {
+            _arenas[i].deallocate(p, class_size(i));
+        }
+        else if(_arenas[classes].owns(p)) {
+            _arenas[classes].deallocate(p, s);
+        }
+        else {
+            throw invalid_argument("Bad arguments passed to deallocate");
+        }
+    }
+
+    // -------
+    // destroy
+    // -------
+
+    /**
+     * O(1) in space
+     * O(1) in time
+     */
+    void destroy (pointer p) {
+        p->~T();
+    }
+};
+
+#endif // SizeClassAllocator_h
@@ -0,0 +1,139 @@
+// ----------
+// Snapshot.h
+// ----------
+
+#ifndef Snapshot_h
+#define Snapshot_h
+
+// --------
+// includes
+// --------
+
+#include <cstddef>  // size_t
+#include <cstdlib>  // abs
+#include <iostream> // istream, ostream
+#include <string>
+#include <utility>  // pair
+#include <vector>
+
+// -------------
+// binary format
+// -------------
+
+// a snapshot is
+//     "ALSN" arena-size tick run-count (count size)...
+// every number is an unsigned LEB128 varint, and size is zigzag encoded
+// a run is count consecutive blocks with the same sentinel, negative for busy blocks, positive for free ones
+// block offsets are implicit, every block takes abs(size) + 8 bytes of the arena
+
+// ------
+// varint
+// ------
+
+/**
+ * O(1) in space
+ * O(log n) in time
+ */
+inline void write_varint (std::string& out, std::size_t n) {
+    while(n >= 0x80) {
+        out += (char)((n & 0x7F) | 0x80);
+        n >>= 7;
+    }
+    out += (char)n;
+}
+
+/**
+ * O(1) in space
+ * O(log n) in time
+ * returns false, if in ends before the varint does
+ */
+inline bool read_varint (std::istream& in, std::size_t& n) {
+    n = 0;
+    int shift = 0;
+    int c;
+    do {
+        c = in.get();
+        if(c == EOF || shift >= 64) {
+            return false;
+        }
+        n |= (std::size_t)(c & 0x7F) << shift;
+        shift += 7;
+    } while(c & 0x80);
+    return true;
+}
+
+// --------
+// snapshot
+// --------
+
+struct snapshot {
+    std::size_t                              arena = 0;
+    std::size_t                              tick  = 0;
+    std::vector<std::pair<std::size_t, int>> runs;      // (count, sentinel)
+};
+
+// --------------
+// write_snapshot
+// --------------
+
+/**
+ * O(r) in space, r being the number of runs
+ * O(n) in time
+ * writes one run-length encoded snapshot of the blocks of x to out with a single write
+ */
+template <typename A>
+void write_snapshot (std::ostream& out, const A& x, std::size_t tick) {
+    std::vector<std::pair<std::size_t, int>> runs;
+    std::size_t arena = 0;
+    typename A::const_iterator b = x.begin();
+    typename A::const_iterator e = x.end();
+    while(b != e) {
+        if(runs.empty() || runs.back().second != *b) {
+            runs.emplace_back(0, *b);
+        }
+        ++runs.back().first;
+        arena += std::abs(*b) + 8;
+        ++b;
+    }
+    std::string s = "ALSN";
+    write_varint(s, arena);
+    write_varint(s, tick);
+    write_varint(s, runs.size());
+    for(const std::pair<std::size_t, int>& r : runs) {
+        write_varint(s, r.first);
+        write_varint(s, ((std::size_t)r.second << 1) ^ (std::size_t)(r.second >> 31));
+    }
+    out.write(s.data(), s.size());
+}
+
+// -------------
+// read_snapshot
+// -------------
+
+/**
+ * O(r) in space, r being the number of runs
+ * O(r) in time
+ * returns false at the end of in or on a malformed snapshot
+ */
+inline bool read_snapshot (std::istream& in, snapshot& x) {
+    char magic[4];
+    if(!in.read(magic, 4) || std::string(magic, 4) != "ALSN") {
+        return false;
+    }
+    std::size_t n;
+    if(!read_varint(in, x.arena) || !read_varint(in, x.tick) || !read_varint(in, n)) {
+        return false;
+    }
+    x.runs.clear();
+    for(std::size_t i = 0; i != n; ++i) {
+        std::size_t count;
+        std::size_t size;
+        if(!read_varint(in, count) || !read_varint(in, size)) {
+            return false;
+        }
+        x.runs.emplace_back(count, (int)(size >> 1) ^ -(int)(size & 1));
+    }
+    return true;
+}
+
+#endif // Snapshot_h
@@ -13,11 +13,16 @@
 #include <algorithm> // count
 #include <cstddef>   // ptrdiff_t
 #include <memory>    // allocator
+#include <sstream>   // ostringstream
 #include <string>
+#include <type_traits> // is_trivially_destructible
 
 #include "gtest/gtest.h"
 #include <iostream>
 #include "Allocator.hpp"
+#include "SizeClassAllocator.hpp"
+#include "Snapshot.hpp"
+#include "TypedArena.hpp"
 
 TEST(AllocatorFixture, test0) {
     using allocator_type = std::allocator<int>;
@@ -261,3 +266,352 @@ TEST(AllocatorFixture, test20) {
     x.deallocate(p2, 3);
     ASSERT_EQ(printAllocator(x), "72 -24 880");
 }
+
+TEST(AllocatorFixture, test21) {
+    my_allocator<double, 1000> x;
+    double* p = x.allocate(123);
+    ASSERT_EQ(*x.begin(), -992);
+    x.deallocate(p, 123);
+    ASSERT_EQ(printAllocator(x), "992");
+}
+
+TEST(AllocatorFixture, test22) {
+    my_allocator<double, 1000> x;
+    double* p = x.allocate(5);
+    ASSERT_THROW(x.deallocate(p, 3), invalid_argument);
+    ASSERT_THROW(x.deallocate(p, 6), invalid_argument);
+}
+
+//owns tests
+TEST(AllocatorFixture, test23) {
+    my_allocator<double, 1000> x;
+    my_allocator<double, 1000> y;
+    double* p = x.allocate(5);
+    ASSERT_EQ(x.owns(p), true);
+    ASSERT_EQ(y.owns(p), false);
+}
+
+//size class tests
+TEST(SizeClassAllocatorFixture, test0) {
+    using allocator_type = size_class_allocator<double, 1000, 8>;
+    ASSERT_EQ(allocator_type::classes, 4u);
+    ASSERT_EQ(allocator_type::arena_index(1), 0u);
+    ASSERT_EQ(allocator_type::arena_index(3), 2u);
+    ASSERT_EQ(allocator_type::arena_index(8), 3u);
+    ASSERT_EQ(allocator_type::arena_index(9), 4u);
+}
+
+TEST(SizeClassAllocatorFixture, test1) {
+    size_class_allocator<double, 1000, 8> x;
+    double* p = x.allocate(3);
+    ASSERT_EQ(x.arena(2).owns(p), true);
+    ASSERT_EQ(*x.arena(2).begin(), -32);
+    x.deallocate(p, 3);
+    ASSERT_EQ(*x.arena(2).begin(), 992);
+    ASSERT_EQ(x.isValid(), true);
+}
+
+TEST(SizeClassAllocatorFixture, test2) {
+    size_class_allocator<double, 1000, 8> x;
+    double* p = x.allocate(20);
+    ASSERT_EQ(x.arena(4).owns(p), true);
+    x.deallocate(p, 20);
+    ASSERT_EQ(*x.arena(4).begin(), 992);
+}
+
+TEST(SizeClassAllocatorFixture, test3) {
+    size_class_allocator<double, 1000, 8> x;
+    double* p = nullptr;
+    for(int n = 0; n < 14; ++n) {
+        p = x.allocate(8);
+    }
+    ASSERT_EQ(x.arena(4).owns(p), true);
+    x.deallocate(p, 8);
+    ASSERT_EQ(x.isValid(), true);
+}
+
+TEST(SizeClassAllocatorFixture, test4) {
+    size_class_allocator<double, 1000, 8> x;
+    my_allocator<double, 1000> y;
+    double* p = y.allocate(1);
+    ASSERT_THROW(x.deallocate(p, 1), invalid_argument);
+}
+
+//debug mode tests
+int canaryOf(my_allocator<double, 1000, true>& x) {
+    return x[4];
+}
+
+TEST(DebugAllocatorFixture, test0) {
+    my_allocator<double, 1000, true> x;
+    double* p = x.allocate(5, "test0");
+    ASSERT_EQ(*x.begin(), -64);
+    ostringstream out;
+    ASSERT_EQ(x.check(out), 0u);
+    x.deallocate(p, 5);
+    ASSERT_EQ(*x.begin(), 992);
+    ASSERT_EQ(x.report(out), 0u);
+    ASSERT_EQ(out.str(), "");
+}
+
+TEST(DebugAllocatorFixture, test1) {
+    my_allocator<double, 1000, true> x;
+    double* p = x.allocate(5, "test1");
+    p[5] = 0;
+    ostringstream out;
+    ASSERT_EQ(x.check(out), 1u);
+    ASSERT_EQ(out.str(), "overwrite: offset 60 in block at offset 0, test1\n");
+    *(reinterpret_cast<int*>(p) + 10) = canaryOf(x);
+    *(reinterpret_cast<int*>(p) + 11) = canaryOf(x);
+    x.deallocate(p, 5);
+}
+
+TEST(DebugAllocatorFixture, test2) {
+    my_allocator<double, 1000, true> x;
+    double* p = x.allocate(5);
+    x.allocate(3);
+    x.deallocate(p, 5);
+    *reinterpret_cast<char*>(p) = 0;
+    ostringstream out;
+    ASSERT_EQ(x.report(out), 2u);
+    ASSERT_EQ(out.str(),
+              "overwrite: offset 20 in free block at offset 0\n"
+              "leak: block at offset 72, 24 bytes, untagged\n");
+}
+
+TEST(DebugAllocatorFixture, test3) {
+    my_allocator<double, 1000, true> x;
+    double* p = x.allocate(2, ALLOCATOR_TAG);
+    ostringstream out;
+    ASSERT_EQ(x.report(out), 1u);
+    ASSERT_NE(out.str().find("TestAllocator.cpp"), string::npos);
+    x.deallocate(p, 2);
+}
+
+TEST(DebugAllocatorFixture, test4) {
+    my_allocator<double, 1000> x;
+    double* p = x.allocate(5);
+    p[5] = 0;
+    ostringstream out;
+    ASSERT_EQ(x.report(out), 0u);
+    ASSERT_EQ(out.str(), "");
+}
+
+TEST(DebugAllocatorFixture, test5) {
+    ASSERT_TRUE((is_trivially_destructible<my_allocator<double, 1000>>::value));
+    ASSERT_FALSE((is_trivially_destructible<my_allocator<double, 1000, true>>::value));
+}
+
+//snapshot tests
+TEST(SnapshotFixture, test0) {
+    my_allocator<double, 1000> x;
+    x.allocate(5);
+    x.allocate(5);
+    x.allocate(3);
+    stringstream out;
+    write_snapshot(out, x, 7);
+    snapshot y;
+    ASSERT_EQ(read_snapshot(out, y), true);
+    ASSERT_EQ(y.arena, 1000u);
+    ASSERT_EQ(y.tick, 7u);
+    ASSERT_EQ(y.runs.size(), 3u);
+    ASSERT_EQ(y.runs[0], make_pair(size_t(2), -40));
+    ASSERT_EQ(y.runs[1], make_pair(size_t(1), -24));
+    ASSERT_EQ(y.runs[2], make_pair(size_t(1), 864));
+    ASSERT_EQ(read_snapshot(out, y), false);
+}
+
+TEST(SnapshotFixture, test1) {
+    my_allocator<double, 1000> x;
+    stringstream out;
+    write_snapshot(out, x, 0);
+    x.allocate(124);
+    write_snapshot(out, x, 1);
+    snapshot y;
+    ASSERT_EQ(read_snapshot(out, y), true);
+    ASSERT_EQ(y.runs[0], make_pair(size_t(1), 992));
+    ASSERT_EQ(read_snapshot(out, y), true);
+    ASSERT_EQ(y.runs[0], make_pair(size_t(1), -992));
+}
+
+TEST(SnapshotFixture, test2) {
+    stringstream out("ALSX");
+    snapshot y;
+    ASSERT_EQ(read_snapshot(out, y), false);
+}
+
+//typed arena tests
+struct counted {
+    static int live;
+    int        v;
+    counted (int v) : v(v) {
+        ++live;
+    }
+    ~counted () {
+        --live;
+    }
+};
+
+int counted::live = 0;
+
+TEST(TypedArenaFixture, test0) {
+    ASSERT_EQ(type_layout<char>::size, sizeof(size_t));
+    ASSERT_EQ(type_layout<double[3]>::size, 24u);
+    ASSERT_EQ((type_index<double, int, double, char>::value), 1u);
+    ASSERT_EQ((type_index<float, int, double, char>::value), 3u);
+}
+
+TEST(TypedArenaFixture, test1) {
+    typed_arena<256, char, double, counted> x;
+    char*    c = x.make<char>('a');
+    double*  d = x.make<double>(2.5);
+    counted* p = x.make<counted>(7);
+    ASSERT_EQ(*c, 'a');
+    ASSERT_EQ(*d, 2.5);
+    ASSERT_EQ(p->v, 7);
+    ASSERT_EQ(counted::live, 1);
+    ASSERT_EQ(reinterpret_cast<size_t>(d) % alignof(double), 0u);
+    x.destroy(p);
+    ASSERT_EQ(counted::live, 0);
+    ASSERT_EQ(x.make<counted>(8), p);
+    ASSERT_EQ(counted::live, 1);
+}
+
+TEST(TypedArenaFixture, test2) {
+    typed_arena<32, double, char> x;
+    double* d = x.make<double>(1.0);
+    x.make<double>(2.0);
+    x.make<char>('b');
+    x.make<double>(3.0);
+    ASSERT_EQ(x.used(), 32u);
+    ASSERT_THROW(x.make<char>('c'), bad_alloc);
+    x.destroy(d);
+    ASSERT_THROW(x.make<char>('c'), bad_alloc);
+    ASSERT_EQ(x.make<double>(4.0), d);
+}
+
+//phase tests
+TEST(PhaseAllocatorFixture, test0) {
+    my_allocator<double, 1000> x;
+    double* p = x.allocate(5);
+    x.begin_phase();
+    ASSERT_EQ(x.in_phase(), true);
+    ASSERT_EQ(printAllocator(x), "-40 -944");
+    double* q = x.allocate(3);
+    double* r = x.allocate(2);
+    ASSERT_EQ(q, p + 6);
+    ASSERT_EQ(r, q + 3);
+    x.deallocate(q, 3);
+    ASSERT_EQ(printAllocator(x), "-40 -944");
+    x.release();
+    ASSERT_EQ(x.in_phase(), false);
+    ASSERT_EQ(printAllocator(x), "-40 944");
+    ASSERT_EQ(x.isValid(), true);
+}
+
+TEST(PhaseAllocatorFixture, test1) {
+    my_allocator<double, 1000> x;
+    double* p = x.allocate(100);
+    x.allocate(5);
+    x.deallocate(p, 100);
+    x.begin_phase();
+    ASSERT_EQ(printAllocator(x), "-800 -40 136");
+    x.allocate(100);
+    double* q = x.allocate(1);
+    ASSERT_EQ(printAllocator(x), "-800 -40 -8 120");
+    x.release();
+    x.deallocate(q, 1);
+    ASSERT_EQ(printAllocator(x), "800 -40 136");
+}
+
+TEST(PhaseAllocatorFixture, test2) {
+    my_allocator<double, 1000> x;
+    double* p = x.allocate(5);
+    x.begin_phase();
+    x.deallocate(p, 5);
+    x.release();
+    ASSERT_EQ(printAllocator(x), "992");
+    ASSERT_EQ(x.isValid(), true);
+}
+
+TEST(PhaseAllocatorFixture, test3) {
+    my_allocator<double, 1000> x;
+    x.allocate(124);
+    ASSERT_THROW(x.begin_phase(), bad_alloc);
+    my_allocator<double, 1000> y;
+    y.begin_phase();
+    ASSERT_THROW(y.begin_phase(), logic_error);
+}
+
+TEST(PhaseAllocatorFixture, test4) {
+    my_allocator<double, 1000, true> x;
+    x.begin_phase();
+    x.allocate(4);
+    ostringstream out;
+    ASSERT_EQ(x.report(out), 0u);
+    x.release();
+    ASSERT_EQ(x.report(out), 0u);
+    ASSERT_EQ(out.str(), "");
+}
+
+//free tree tests
+TEST(FreeTreeFixture, test0) {
+    my_allocator<double, 1000> x;
+    double* p = x.allocate(10);
+    x.allocate(1);
+    double* q = x.allocate(3);
+    x.allocate(1);
+    x.deallocate(p, 10);
+    x.deallocate(q, 3);
+    ASSERT_EQ(printAllocator(x), "80 -8 24 -8 840");
+    double* r = x.allocate_best_fit(2);
+    ASSERT_EQ(r, q);
+    ASSERT_EQ(printAllocator(x), "80 -8 -24 -8 840");
+    ASSERT_EQ(x.allocate_best_fit(10), p);
+    ASSERT_EQ(x.isValid(), true);
+}
+
+TEST(FreeTreeFixture, test1) {
+    my_allocator<double, 1000> x;
+    x.allocate(124);
+    ASSERT_THROW(x.allocate_best_fit(1), bad_alloc);
+}
+
+TEST(FreeTreeFixture, test2) {
+    my_allocator<double, 1000> x;
+    double* p = x.allocate(5);
+    x.allocate(1);
+    x.deallocate(p, 5);
+    *(reinterpret_cast<int*>(p) + 1) = 4;
+    ASSERT_EQ(x.isValid(), false);
+}
+
+TEST(FreeTreeFixture, test3) {
+    my_allocator<double, 4000> x;
+    vector<pair<double*, size_t>> live;
+    srand(3);
+    for(int n = 0; n < 2000; ++n) {
+        if(!live.empty() && rand() % 2 == 0) {
+            size_t i = rand() % live.size();
+            x.deallocate(live[i].first, live[i].second);
+            live.erase(live.begin() + i);
+        }
+        else {
+            size_t s = rand() % 12 + 1;
+            int best = 0;
+            for(my_allocator<double, 4000>::iterator b = x.begin(); b != x.end(); ++b) {
+                if(*b >= (int)s * 8 && (best == 0 || *b < best)) {
+                    best = *b;
+                }
+            }
+            if(best == 0) {
+                ASSERT_THROW(x.allocate_best_fit(s), bad_alloc);
+                continue;
+            }
+            double* p = x.allocate_best_fit(s);
+            ASSERT_GE(*(reinterpret_cast<int*>(p) - 1), -best);
+            live.emplace_back(p, s);
+        }
+        ASSERT_EQ(x.isValid(), true);
+    }
+}
@@ -0,0 +1,133 @@
+// ----------------------
+// TestAsyncAllocator.c++
+// ----------------------
+
+// https://github.com/google/googletest
+// https://github.com/google/googletest/blob/master/googletest/docs/primer.md
+// https://github.com/google/googletest/blob/master/googletest/docs/advanced.md
+
+// async_allocator needs C++20 coroutines, so its tests are built separately from TestAllocator.cpp,
+// which uses std::allocator::construct, removed in C++20
+
+// --------
+// includes
+// --------
+
+#include <coroutine> // suspend_never
+#include <exception> // terminate
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "AsyncAllocator.hpp"
+
+// ----
+// task
+// ----
+
+/**
+ * a coroutine that starts eagerly and frees its own frame when it finishes
+ */
+struct task {
+    struct promise_type {
+        task get_return_object () {
+            return {};
+        }
+        std::suspend_never initial_suspend () {
+            return {};
+        }
+        std::suspend_never final_suspend () noexcept {
+            return {};
+        }
+        void return_void () {}
+        void unhandled_exception () {
+            std::terminate();
+        }
+    };
+};
+
+using allocator_type = async_allocator<double, 1000>;
+
+task request (allocator_type& x, size_t s, std::vector<double*>& out) {
+    double* p = co_await x.allocate_async(s);
+    out.push_back(p);
+}
+
+task request_and_free (allocator_type& x, size_t s, std::vector<double*>& out) {
+    double* p = co_await x.allocate_async(s);
+    out.push_back(p);
+    x.deallocate(p, s);
+}
+
+TEST(AsyncAllocatorFixture, test0) {
+    allocator_type       x;
+    std::vector<double*> out;
+    request(x, 5, out);
+    ASSERT_EQ(out.size(), 1u);
+    ASSERT_EQ(x.waiting(), 0u);
+    ASSERT_EQ(*x.arena().begin(), -40);
+}
+
+TEST(AsyncAllocatorFixture, test1) {
+    allocator_type       x;
+    std::vector<double*> out;
+    double* p = x.allocate(124);
+    request(x, 10, out);
+    request(x, 3, out);
+    ASSERT_EQ(out.size(), 0u);
+    ASSERT_EQ(x.waiting(), 2u);
+    x.deallocate(p, 124);
+    ASSERT_EQ(out.size(), 2u);
+    ASSERT_EQ(x.waiting(), 0u);
+    ASSERT_EQ(out[0], p);
+    ASSERT_EQ(x.isValid(), true);
+}
+
+TEST(AsyncAllocatorFixture, test2) {
+    allocator_type       x;
+    std::vector<double*> out;
+    double* p = x.allocate(60);
+    double* q = x.allocate(60);
+    request(x, 100, out);
+    request(x, 1, out);
+    ASSERT_EQ(x.waiting(), 2u);
+    x.deallocate(p, 60);
+    ASSERT_EQ(out.size(), 0u);
+    x.deallocate(q, 60);
+    ASSERT_EQ(out.size(), 2u);
+}
+
+TEST(AsyncAllocatorFixture, test3) {
+    allocator_type       x;
+    std::vector<double*> out;
+    double* p = x.allocate(124);
+    request_and_free(x, 100, out);
+    request_and_free(x, 100, out);
+    request(x, 120, out);
+    x.deallocate(p, 124);
+    ASSERT_EQ(out.size(), 3u);
+    ASSERT_EQ(x.waiting(), 0u);
+    ASSERT_EQ(out[0], p);
+    ASSERT_EQ(out[1], p);
+    ASSERT_EQ(out[2], p);
+}
+
+TEST(AsyncAllocatorFixture, test4) {
+    allocator_type x;
+    ASSERT_THROW(x.allocate_async(125).await_ready(), bad_alloc);
+}
+
+TEST(AsyncAllocatorFixture, test5) {
+    allocator_type       x;
+    std::vector<double*> out;
+    double* p = x.allocate(60);
+    double* q = x.allocate(60);
+    request(x, 100, out);
+    ASSERT_EQ(x.waiting(), 1u);
+    ASSERT_THROW(x.allocate(1), bad_alloc);
+    x.deallocate(p, 60);
+    ASSERT_THROW(x.allocate(1), bad_alloc);
+    x.deallocate(q, 60);
+    ASSERT_EQ(out.size(), 1u);
+    ASSERT_EQ(x.waiting(), 0u);
+    ASSERT_NE(x.allocate(1), nullptr);
+}
@@ -0,0 +1,203 @@
+// ------------
+// TypedArena.h
+// ------------
+
+#ifndef TypedArena_h
+#define TypedArena_h
+
+// --------
+// includes
+// --------
+
+#include <array>       // array
+#include <cstddef>     // size_t
+#include <initializer_list> // initializer_list
+#include <new>         // bad_alloc, new
+#include <type_traits> // is_same
+#include <utility>     // forward
+
+// -----------
+// type_layout
+// -----------
+
+/**
+ * the compile-time layout of the slots of U
+ * a slot must be able to hold the free-list link once U is destroyed
+ */
+template <typename U>
+struct type_layout {
+    static constexpr std::size_t align = alignof(U) > alignof(std::size_t) ? alignof(U) : alignof(std::size_t);
+    static constexpr std::size_t size  = ((sizeof(U) > sizeof(std::size_t) ? sizeof(U) : sizeof(std::size_t)) + align - 1) / align * align;
+};
+
+// ----------
+// type_index
+// ----------
+
+/**
+ * the position of U in Ts, sizeof...(Ts) if U is not in Ts
+ */
+template <typename U, typename... Ts>
+struct type_index;
+
+template <typename U>
+struct type_index<U> {
+    static constexpr std::size_t value = 0;
+};
+
+template <typename U, typename T, typename... Ts>
+struct type_index<U, T, Ts...> {
+    static constexpr std::size_t value = std::is_same<U, T>::value ? 0 : 1 + type_index<U, Ts...>::value;
+};
+
+// -----------
+// typed_arena
+// -----------
+
+/**
+ * serves objects of every type in Ts out of one char buffer of N bytes
+ * slots are carved from the buffer with a bump offset and recycled through one free list per type,
+ * so make and destroy are O(1) and all size and alignment math is done at compile time
+ */
+template <std::size_t N, typename... Ts>
+class typed_arena {
+    static_assert(sizeof...(Ts) > 0, "typed_arena needs at least one type");
+
+public:
+    // --------
+    // typedefs
+    // --------
+
+    using size_type = std::size_t;
+
+    // ---------
+    // constants
+    // ---------
+
+    static constexpr size_type types = sizeof...(Ts);
+
+    /**
+     * the largest alignment of any slot, the alignment of the buffer
+     */
+    static constexpr size_type align = [] {
+        size_type r = 1;
+        for(size_type x : {type_layout<Ts>::align...}) {
+            r = x > r ? x : r;
+        }
+        return r;
+    } ();
+
+private:
+    // ---------
+    // constants
+    // ---------
+
+    static constexpr size_type none = N;               // the end of a free list
+
+    // ----
+    // data
+    // ----
+
+    alignas(align) char          a[N];
+    size_type                    _top = 0;          // the first byte never handed out
+    std::array<size_type, types> _free;             // the first free slot of each type
+
+    // ----
+    // link
+    // ----
+
+    /**
+     * O(1) in space
+     * O(1) in time
+     * the free-list link stored in the slot at offset i
+     */
+    size_type& link (size_type i) {
+        return *reinterpret_cast<size_type*>(a + i);
+    }
+
+public:
+    // -----------
+    // constructor
+    // -----------
+
+    /**
+     * O(1) in space
+     * O(1) in time
+     */
+    typed_arena () {
+        _free.fill(none);
+    }
+
+    typed_arena             (const typed_arena&) = delete;
+    ~typed_arena            ()                   = default;
+    typed_arena& operator = (const typed_arena&) = delete;
+
+    // ----
+    // make
+    // ----
+
+    /**
+     * O(1) in space
+     * O(1) in time
+     * reuses the most recently destroyed slot of U, or carves a new one off the end of the buffer
+     * throw a bad_alloc exception, if there is no room for another U
+     */
+    template <typename U, typename... Args>
+    U* make (Args&&... args) {
+        constexpr size_type i = type_index<U, Ts...>::value;
+        static_assert(i != types, "U is not one of the arena's types");
+        size_type p = _free[i];
+        if(p != none) {
+            _free[i] = link(p);
+        }
+        else {
+            p = (_top + type_layout<U>::align - 1) / type_layout<U>::align * type_layout<U>::align;
+            if(p + type_layout<U>::size > N) {
+                throw std::bad_alloc();
+            }
+            _top = p + type_layout<U>::size;
+        }
+        try {
+            return new (a + p) U(std::forward<Args>(args)...);
+        }
+        catch(...) {
+            link(p)  = _free[i];
+            _free[i] = p;
+            throw;
+        }
+    }
+
+    // -------
+    // destroy
+    // -------
+
+    /**
+     * O(1) in space
+     * O(1) in time
+     * destroys *p and pushes its slot onto the free list of U
+     */
+    template <typename U>
+    void destroy (U* p) {
+        constexpr size_type i = type_index<U, Ts...>::value;
+        static_assert(i != types, "U is not one of the arena's types");
+        p->~U();
+        const size_type q = reinterpret_cast<char*>(p) - a;
+        link(q)  = _free[i];
+        _free[i] = q;
+    }
+
+    // ----
+    // used
+    // ----
+
+    /**
+     * O(1) in space
+     * O(1) in time
+     * the number of bytes of the buffer that have been carved into slots
+     */
+    size_type used () const {
+        return _top;
+    }
+};
+
+#endif // TypedArena_h